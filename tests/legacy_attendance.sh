@@ -0,0 +1,36 @@
+#!/bin/sh
+# Attendance rows whose date is not YYYY-MM-DD (accepted by older versions)
+# must survive every rewrite of attendance.txt, whether the table was loaded
+# from the text file or from attendance.bin.
+#
+# usage: tests/legacy_attendance.sh   (needs a C compiler as $CC or cc)
+set -e
+src="$(cd "$(dirname "$0")/.." && pwd)/Main_Code.c"
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+${CC:-cc} -O2 -o "$dir/uni-verse" "$src" -pthread
+cd "$dir"
+
+legacy='S1,C1,12/03/2024,1'
+printf '%s\nS2,C1,2024-03-12,1\n' "$legacy" > attendance.txt
+# Re-marking one lecture 300 times leaves enough superseded lines to make
+# the next checkpoint compact attendance.txt from memory
+i=0
+while [ $i -lt 300 ]; do echo "S2,C1,2024-03-12,$((i % 2))"; i=$((i + 1)); done > marks.csv
+
+check() {
+    if ! grep -qx "$legacy" attendance.txt; then
+        echo "FAIL: legacy row lost $1"
+        cat attendance.txt
+        exit 1
+    fi
+}
+
+./uni-verse import-attendance marks.csv > /dev/null 2>&1
+check "after compacting from text"
+[ "$(wc -l < attendance.txt)" -eq 2 ] || { echo "FAIL: attendance.txt was not compacted"; exit 1; }
+
+./uni-verse export-binary > /dev/null 2>&1
+./uni-verse import-attendance marks.csv > /dev/null 2>&1
+check "after compacting from attendance.bin"
+echo "PASS"